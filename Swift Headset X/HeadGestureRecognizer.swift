@@ -0,0 +1,158 @@
+//
+//  HeadGestureRecognizer.swift
+//  Swift Headset X
+//
+//  Created by Florian Heller on 19.10.26.
+//  Copyright © 2026 Florian Heller. All rights reserved.
+//
+
+import Foundation
+
+enum HeadGesture {
+	case nod
+	case shake
+	case tiltLeft
+	case tiltRight
+}
+
+protocol HeadGestureRecognizerDelegate: AnyObject {
+	func headGestureRecognizer(_ recognizer: HeadGestureRecognizer, didRecognize gesture: HeadGesture)
+}
+
+/// Recognizes nodding, head shaking and tilting from the yaw, pitch and roll reported by the headset (in degrees).
+/// Every sample is processed in constant time and without allocations, so it can be fed at the full sensor rate.
+class HeadGestureRecognizer {
+
+	/// Counts back-and-forth swings of one axis that are larger than `minimumAmplitude`
+	struct SwingDetector {
+		let minimumAmplitude: Float
+		let maximumInterval: TimeInterval //Maximum time between two reversals before the count starts over
+		var position: Float = 0 //Unwrapped angle, so yaw can be followed across 0/360
+		var extremum: Float = 0
+		var direction: Float = 0 //+1 or -1 once the axis started moving, 0 at rest
+		var lastReversal: TimeInterval = 0
+		var swings = 0
+
+		init(minimumAmplitude: Float, maximumInterval: TimeInterval) {
+			self.minimumAmplitude = minimumAmplitude
+			self.maximumInterval = maximumInterval
+		}
+
+		mutating func reset() {
+			extremum = position
+			direction = 0
+			swings = 0
+		}
+
+		mutating func add(delta: Float, at time: TimeInterval) {
+			position += delta
+			if direction != 0 && time - lastReversal > maximumInterval {
+				reset()
+			}
+			let offset = position - extremum
+			if direction == 0 {
+				if abs(offset) >= minimumAmplitude {
+					direction = offset > 0 ? 1 : -1
+					extremum = position
+					lastReversal = time
+				}
+			}
+			else if offset * direction > 0 { //Still moving the same way, follow the peak
+				extremum = position
+			}
+			else if -offset * direction >= minimumAmplitude { //Moved back far enough to count as a swing
+				swings += 1
+				direction = -direction
+				extremum = position
+				lastReversal = time
+			}
+		}
+	}
+
+	weak var delegate: HeadGestureRecognizerDelegate?
+
+	var nodSwings = 2
+	var shakeSwings = 3
+	var tiltAngle: Float = 20.0
+	var tiltDuration: TimeInterval = 0.3
+	var refractoryPeriod: TimeInterval = 0.5 //Ignore further gestures for a moment so the end of one is not taken as the start of the next
+	var restingSpeed: Float = 30.0 //Degrees per second, faster movement during the refractory period extends it until the head has settled
+
+	private var yawDetector = SwingDetector(minimumAmplitude: 10.0, maximumInterval: 0.6)
+	private var pitchDetector = SwingDetector(minimumAmplitude: 8.0, maximumInterval: 0.6)
+	private var lastYaw: Float = 0
+	private var lastPitch: Float = 0
+	private var lastTime: TimeInterval = 0
+	private var hasSample = false
+	private var tiltStart: TimeInterval?
+	private var tiltReported = false
+	private var blockedUntil: TimeInterval = 0
+
+	func reset() {
+		hasSample = false
+		yawDetector.reset()
+		pitchDetector.reset()
+		tiltStart = nil
+		tiltReported = false
+	}
+
+	/// Feed a new orientation sample. Positive roll is assumed to be a tilt to the right.
+	func add(yaw: Float, pitch: Float, roll: Float, at time: TimeInterval = ProcessInfo.processInfo.systemUptime) {
+		if !hasSample {
+			lastYaw = yaw
+			lastPitch = pitch
+			lastTime = time
+			hasSample = true
+			return
+		}
+		var yawDelta = yaw - lastYaw
+		if yawDelta > 180 { yawDelta -= 360 }
+		else if yawDelta < -180 { yawDelta += 360 }
+		lastYaw = yaw
+		let pitchDelta = pitch - lastPitch
+		lastPitch = pitch
+		let interval = time - lastTime
+		lastTime = time
+
+		if abs(roll) >= tiltAngle {
+			if tiltStart == nil {
+				tiltStart = time
+			}
+		}
+		else {
+			tiltStart = nil //The roll has to stay past the angle for the whole duration
+			if abs(roll) < tiltAngle / 2 { //Hysteresis, the head has to come back up before the next tilt
+				tiltReported = false
+			}
+		}
+
+		//The swing detectors are not fed while blocked, so the rest of a gesture cannot build up the next one
+		guard time >= blockedUntil else {
+			if interval > 0 && max(abs(yawDelta), abs(pitchDelta)) / Float(interval) > restingSpeed {
+				blockedUntil = time + refractoryPeriod
+			}
+			return
+		}
+		yawDetector.add(delta: yawDelta, at: time)
+		pitchDetector.add(delta: pitchDelta, at: time)
+
+		// A nod must not be mistaken for a shake and vice versa, so the other axis has to be calm
+		if yawDetector.swings >= shakeSwings && pitchDetector.swings < nodSwings {
+			recognized(.shake, at: time)
+		}
+		else if pitchDetector.swings >= nodSwings && yawDetector.swings == 0 {
+			recognized(.nod, at: time)
+		}
+		else if let start = tiltStart, !tiltReported, time - start >= tiltDuration {
+			tiltReported = true
+			recognized(roll > 0 ? .tiltRight : .tiltLeft, at: time)
+		}
+	}
+
+	private func recognized(_ gesture: HeadGesture, at time: TimeInterval) {
+		yawDetector.reset()
+		pitchDetector.reset()
+		blockedUntil = time + refractoryPeriod
+		delegate?.headGestureRecognizer(self, didRecognize: gesture)
+	}
+}
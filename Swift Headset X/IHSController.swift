@@ -9,7 +9,7 @@
 import UIKit
 import CoreBluetooth
 
-class IHSController: NSObject, IHSDeviceDelegate, IHSSensorsDelegate {
+class IHSController: NSObject, IHSDeviceDelegate, IHSSensorsDelegate, HeadGestureRecognizerDelegate, PedestrianDeadReckoningDelegate {
 
 	@IBOutlet weak var statusLabel: UILabel!
 	@IBOutlet weak var headingLabel: UILabel!
@@ -18,9 +18,24 @@ class IHSController: NSObject, IHSDeviceDelegate, IHSSensorsDelegate {
 	var ihsDevice:IHSDevice?
 	var btManager: CBCentralManager!
 	
+	//Reconnect automatically if an established connection drops, e.g. after going out of range. Delays double after each attempt.
+	let maxReconnectAttempts = 5
+	let initialReconnectDelay: TimeInterval = 1.0
+	var shouldReconnect = false //Only armed once a connection was made, so a failed first connect is not retried
+	var reconnectAttempts = 0
+	var reconnectWorkItem: DispatchWorkItem?
+	let reconnectAttemptTimeout: TimeInterval = 15.0 //An attempt that neither connects nor fails within this time counts as failed
+	var reconnectTimeoutWorkItem: DispatchWorkItem?
+	var connectionLostTime: TimeInterval? //When the headset started lingering or disconnected, to measure the time to reconnect
+	
+	let headGestureRecognizer = HeadGestureRecognizer()
+	let deadReckoning = PedestrianDeadReckoning()
+	
 	override init() {
 		super.init()
 		btManager = CBCentralManager(delegate: self, queue: nil)
+		headGestureRecognizer.delegate = self
+		deadReckoning.delegate = self
 		
 	}
 	
@@ -32,17 +47,22 @@ class IHSController: NSObject, IHSDeviceDelegate, IHSSensorsDelegate {
 				ihsDevice?.connect()
 			}
 		}
-		else {
+		else { //Disconnect, or Cancel while reconnecting
+			cancelReconnect()
 			if let ihs = ihsDevice {
 				ihs.disconnect()
 				ihs.sensorsDelegate = nil
 				ihs.deviceDelegate = nil
 			}
+			//Without a delegate there will be no callback for the disconnect, so update the UI here
+			connectButton.setTitle("Connect", for: .normal)
+			statusLabel.text = "Disconnected"
 		}
 	}
 	
 	
 	deinit {
+		cancelReconnect()
 		if let ihs = ihsDevice {
 			ihs.disconnect()
 			ihs.sensorsDelegate = nil
@@ -53,6 +73,10 @@ class IHSController: NSObject, IHSDeviceDelegate, IHSSensorsDelegate {
 	//MARK: IHS Device Delegate Methods
 	
 	func ihsDevice(_ ihs: IHSDevice!, connectionStateChanged connectionState: IHSDeviceConnectionState) {
+		if connectionState != .connected { //Do not compare the first samples after a reconnect with stale ones
+			headGestureRecognizer.reset()
+			deadReckoning.reset()
+		}
 		var status = ""
 		switch connectionState {
 		case .none:
@@ -61,18 +85,42 @@ class IHSController: NSObject, IHSDeviceDelegate, IHSSensorsDelegate {
 			status = "Connecting"
 		case .connected: //The state when the heaset is connected and ready to use.
 			status = "Connected"
+			shouldReconnect = true
+			reconnectAttempts = 0
+			reconnectTimeoutWorkItem?.cancel()
+			reconnectTimeoutWorkItem = nil
+			if let lostTime = connectionLostTime {
+				let duration = ProcessInfo.processInfo.systemUptime - lostTime
+				print(String(format: "IHS reconnected after %.1f s", duration))
+				connectionLostTime = nil
+			}
 			connectButton.setTitle("Disconnect", for: .normal)
 		case .connectionFailed:
 			status = "Failed"
+			if shouldReconnect { //A reconnect attempt failed, try again
+				status = retryReconnect() ? "Reconnecting" : status
+			}
 		case .lingering: //If we have not received data from the headset for a while even though we are still conncted. If this state occurs, it is typically a preliminary state to disconnecting.
 			status = "Lingering"
+			if connectionLostTime == nil {
+				connectionLostTime = ProcessInfo.processInfo.systemUptime
+			}
 		case .discovering: //The framework is looking for available headsets in the near proximity.
 			status = "Discovering"
 		case .disconnected: //The headset disconnected. Could be because it was turned off or got out of range.
 			status = "Disconnected"
-			connectButton.setTitle("Connect", for: .normal)
+			if shouldReconnect {
+				if connectionLostTime == nil {
+					connectionLostTime = ProcessInfo.processInfo.systemUptime
+				}
+				status = retryReconnect() ? "Reconnecting" : status
+			}
+			else {
+				connectButton.setTitle("Connect", for: .normal)
+			}
 		case .bluetoothOff: // Bluetooth is turned off. It should be turned on in order to connect.
 			status = "Bluetooth is Off"
+			stopReconnecting() //No point in retrying, the user has to connect again once Bluetooth is back
 		default:
 			status = ""
 		}
@@ -81,14 +129,114 @@ class IHSController: NSObject, IHSDeviceDelegate, IHSSensorsDelegate {
 	}
 	
 	func ihsDeviceFoundAmbiguousDevices(_ ihs: IHSDevice!) {
+		if shouldReconnect {
+			//connect falls back to the device selection if it cannot pick a headset by itself. Do not pop that up unasked during an automatic retry, let the user connect again instead.
+			print("IHS reconnect needs a device selection, giving up")
+			stopReconnecting()
+			ihs.disconnect()
+			statusLabel.text = "Disconnected"
+			return
+		}
 		ihsDevice?.showSelection(viewController)
 	}
 	
+	//MARK: Reconnect
+	
+	/// Schedules the next reconnect attempt unless one is already pending or all attempts are used up. Returns true if a retry is pending.
+	func retryReconnect() -> Bool {
+		if reconnectWorkItem != nil { //A failure can be reported as failed and disconnected, only count it once
+			return true
+		}
+		reconnectTimeoutWorkItem?.cancel() //The current attempt is over
+		reconnectTimeoutWorkItem = nil
+		guard reconnectAttempts < maxReconnectAttempts else {
+			stopReconnecting()
+			return false
+		}
+		let delay = initialReconnectDelay * pow(2.0, Double(reconnectAttempts))
+		reconnectAttempts += 1
+		let workItem = DispatchWorkItem { [weak self] in
+			guard let self = self else { return }
+			self.reconnectWorkItem = nil
+			guard self.shouldReconnect else { return }
+			guard self.btManager.state == .poweredOn else {
+				self.stopReconnecting()
+				self.statusLabel.text = "Bluetooth is Off"
+				return
+			}
+			print("IHS reconnect attempt \(self.reconnectAttempts) of \(self.maxReconnectAttempts)")
+			self.ihsDevice?.connect()
+			self.armReconnectTimeout()
+		}
+		reconnectWorkItem = workItem
+		connectButton.setTitle("Cancel", for: .normal)
+		DispatchQueue.main.asyncAfter(deadline: .now() + delay, execute: workItem)
+		return true
+	}
+	
+	/// Counts an attempt that hangs in discovering or connecting as failed, so the number of attempts stays bounded
+	func armReconnectTimeout() {
+		reconnectTimeoutWorkItem?.cancel()
+		let timeoutItem = DispatchWorkItem { [weak self] in
+			guard let self = self else { return }
+			self.reconnectTimeoutWorkItem = nil
+			guard self.shouldReconnect else { return }
+			print("IHS reconnect attempt \(self.reconnectAttempts) timed out")
+			self.statusLabel.text = self.retryReconnect() ? "Reconnecting" : "Disconnected"
+			self.ihsDevice?.disconnect() //Abort the hanging attempt
+		}
+		reconnectTimeoutWorkItem = timeoutItem
+		DispatchQueue.main.asyncAfter(deadline: .now() + reconnectAttemptTimeout, execute: timeoutItem)
+	}
+	
+	func cancelReconnect() {
+		shouldReconnect = false
+		connectionLostTime = nil
+		reconnectWorkItem?.cancel()
+		reconnectWorkItem = nil
+		reconnectTimeoutWorkItem?.cancel()
+		reconnectTimeoutWorkItem = nil
+	}
+	
+	func stopReconnecting() {
+		cancelReconnect()
+		connectButton.setTitle("Connect", for: .normal)
+	}
+	
 	//MARK: IHS Sensor Delegate Methods
 	
 	func ihsDevice(_ ihs: IHSDevice!, fusedHeadingChanged heading: Float) {
 		print("Heading \(heading)")
 		headingLabel.text = "\(heading)"
+		deadReckoning.updateHeading(heading)
+	}
+	
+	func ihsDevice(_ ihs: IHSDevice!, didChangeYaw yaw: Float, pitch: Float, andRoll roll: Float) {
+		headGestureRecognizer.add(yaw: yaw, pitch: pitch, roll: roll)
+	}
+	
+	func ihsDevice(_ ihs: IHSDevice!, accelerometer3AxisDataChanged data: IHSAHRS3AxisStruct) {
+		deadReckoning.addAcceleration(x: data.x, y: data.y, z: data.z)
+	}
+	
+	func ihsDevice(_ ihs: IHSDevice!, horizontalAccuracyChanged horizontalAccuracy: Double) {
+		deadReckoning.updateHorizontalAccuracy(horizontalAccuracy)
+	}
+	
+	func ihsDevice(_ ihs: IHSDevice!, locationChangedToLatitude latitude: Double, andLogitude longitude: Double) {
+		deadReckoning.addLocation(latitude: latitude, longitude: longitude)
+	}
+	
+	//MARK: Head Gesture Recognizer Delegate Methods
+	
+	func headGestureRecognizer(_ recognizer: HeadGestureRecognizer, didRecognize gesture: HeadGesture) {
+		print("Head gesture \(gesture)")
+	}
+	
+	//MARK: Pedestrian Dead Reckoning Delegate Methods
+	
+	func pedestrianDeadReckoning(_ pdr: PedestrianDeadReckoning, didUpdateLatitude latitude: Double, longitude: Double) {
+		print("Position \(latitude), \(longitude) after \(pdr.stepCount) steps")
 	}
 }
 
@@ -0,0 +1,189 @@
+//
+//  PedestrianDeadReckoning.swift
+//  Swift Headset X
+//
+//  Created by Florian Heller on 19.10.26.
+//  Copyright © 2026 Florian Heller. All rights reserved.
+//
+
+import Foundation
+
+protocol PedestrianDeadReckoningDelegate: AnyObject {
+	func pedestrianDeadReckoning(_ pdr: PedestrianDeadReckoning, didUpdateLatitude latitude: Double, longitude: Double)
+}
+
+/// Estimates the walking position between GPS fixes from the headset's accelerometer and fused heading.
+/// Steps are detected on the acceleration magnitude, the stride length is estimated from the acceleration range of each step (Weinberg),
+/// and GPS fixes are blended in with a simple Kalman filter weighted by the reported horizontal accuracy.
+/// Corrections from a fix are spread over the following samples instead of jumping, and the position is published with every
+/// sample while a correction is in progress. All updates are incremental and O(1) per sample.
+class PedestrianDeadReckoning {
+
+	static let gravity = 9.81 //m/s², the Weinberg stride estimate expects the acceleration range in m/s²
+	static let metersPerDegreeLatitude = 111_320.0
+
+	weak var delegate: PedestrianDeadReckoningDelegate?
+
+	var stepThreshold = 0.12 //Fraction of gravity above the gravity estimate to count as a step
+	var gravityTimeConstant: TimeInterval = 1.0 //Slow average that tracks gravity
+	var smoothingTimeConstant: TimeInterval = 0.05 //Removes sensor noise, short compared to a step
+	var minimumStepInterval: TimeInterval = 0.25
+	var strideConstant = 0.45 //Weinberg K, calibrate per user if needed
+	var defaultAccuracy = 30.0 //Meters, used as long as the headset has not reported an accuracy yet
+	var strideUncertainty = 0.15 //Fraction of each stride added as position variance
+	var headingUncertainty = 10.0 //Degrees, error of the fused heading, adds sideways variance per step
+	var processNoise = 2.0 //m² per second, for movement the steps do not capture (missed steps, vehicles, escalators), keeps the filter listening to GPS
+	var correctionTimeConstant: TimeInterval = 2.0 //How quickly the published position follows a GPS correction
+
+	private(set) var stepCount = 0
+	private(set) var heading = 0.0
+
+	// Acceleration state
+	private var lastSample: TimeInterval?
+	private var gravityEstimate = 0.0
+	private var smoothed = 0.0
+	private var stepMinimum = 0.0
+	private var stepMaximum = 0.0
+	private var aboveThreshold = false
+	private var lastStep: TimeInterval = 0
+
+	// Position in meters east/north of the reference location
+	private var referenceLatitude: Double?
+	private var referenceLongitude = 0.0
+	private var metersPerDegreeLongitude = PedestrianDeadReckoning.metersPerDegreeLatitude
+	private var east = 0.0
+	private var north = 0.0
+	private var variance = 0.0
+	private var lastPrediction: TimeInterval = 0
+	private var horizontalAccuracy: Double?
+	// Part of the last corrections that is not published yet, decays to zero
+	private var pendingEast = 0.0
+	private var pendingNorth = 0.0
+
+	func updateHeading(_ heading: Float) {
+		self.heading = Double(heading)
+	}
+
+	func updateHorizontalAccuracy(_ accuracy: Double) {
+		horizontalAccuracy = accuracy
+	}
+
+	/// Forget the step detection state, e.g. after the sensor stream was interrupted. The position is kept and corrected by the next GPS fix.
+	func reset() {
+		lastSample = nil
+		smoothed = 0
+		stepMinimum = 0
+		stepMaximum = 0
+		aboveThreshold = false
+	}
+
+	/// The headers only give the accelerometer range (-2g to 2g), so the acceleration is measured relative to the gravity estimate and the unit does not matter.
+	func addAcceleration(x: Double, y: Double, z: Double, at time: TimeInterval = ProcessInfo.processInfo.systemUptime) {
+		let magnitude = (x * x + y * y + z * z).squareRoot()
+		guard let previous = lastSample else {
+			lastSample = time
+			gravityEstimate = magnitude
+			return
+		}
+		lastSample = time
+		// Filter factors follow from the time between samples, so the cut-offs do not depend on the sensor rate
+		let interval = max(time - previous, 0)
+		gravityEstimate += (1 - exp(-interval / gravityTimeConstant)) * (magnitude - gravityEstimate)
+		guard gravityEstimate > 0 else { return }
+		let dynamic = (magnitude - gravityEstimate) / gravityEstimate //In units of gravity
+		smoothed += (1 - exp(-interval / smoothingTimeConstant)) * (dynamic - smoothed)
+
+		var moved = false
+		if pendingEast != 0 || pendingNorth != 0 {
+			let remaining = exp(-interval / correctionTimeConstant)
+			pendingEast *= remaining
+			pendingNorth *= remaining
+			if abs(pendingEast) < 0.01 && abs(pendingNorth) < 0.01 {
+				pendingEast = 0
+				pendingNorth = 0
+			}
+			moved = true
+		}
+
+		stepMinimum = min(stepMinimum, smoothed)
+		stepMaximum = max(stepMaximum, smoothed)
+
+		if !aboveThreshold && smoothed > stepThreshold {
+			aboveThreshold = true
+			if time - lastStep >= minimumStepInterval {
+				// Peak to trough since the last step crossing
+				let range = (stepMaximum - stepMinimum) * PedestrianDeadReckoning.gravity
+				lastStep = time
+				stepMinimum = smoothed
+				stepMaximum = smoothed
+				step(length: strideConstant * pow(range, 0.25), at: time)
+				moved = true
+			}
+		}
+		else if aboveThreshold && smoothed < stepThreshold / 2 { //Hysteresis, so noise around the threshold is not counted twice
+			aboveThreshold = false
+		}
+		if moved {
+			notifyDelegate()
+		}
+	}
+
+	func addLocation(latitude: Double, longitude: Double, at time: TimeInterval = ProcessInfo.processInfo.systemUptime) {
+		var accuracy = defaultAccuracy
+		if let reported = horizontalAccuracy {
+			guard reported > 0 else { return } //Negative values mean the fix is invalid, skip it
+			accuracy = reported
+		}
+		guard let refLatitude = referenceLatitude else {
+			referenceLatitude = latitude
+			referenceLongitude = longitude
+			metersPerDegreeLongitude = PedestrianDeadReckoning.metersPerDegreeLatitude * cos(latitude * .pi / 180)
+			east = 0
+			north = 0
+			pendingEast = 0
+			pendingNorth = 0
+			variance = accuracy * accuracy
+			lastPrediction = time
+			notifyDelegate()
+			return
+		}
+		predictVariance(to: time)
+		let measuredEast = (longitude - referenceLongitude) * metersPerDegreeLongitude
+		let measuredNorth = (latitude - refLatitude) * PedestrianDeadReckoning.metersPerDegreeLatitude
+		let gain = variance / (variance + accuracy * accuracy)
+		let correctionEast = gain * (measuredEast - east)
+		let correctionNorth = gain * (measuredNorth - north)
+		east += correctionEast
+		north += correctionNorth
+		//The filter takes the correction right away, the published position slews towards it
+		pendingEast += correctionEast
+		pendingNorth += correctionNorth
+		variance *= 1 - gain
+		notifyDelegate()
+	}
+
+	/// Uncertainty grows with time as well, not only with steps
+	private func predictVariance(to time: TimeInterval) {
+		variance += processNoise * max(time - lastPrediction, 0)
+		lastPrediction = time
+	}
+
+	private func step(length: Double, at time: TimeInterval) {
+		stepCount += 1
+		let radians = heading * .pi / 180 //Heading is clockwise from north
+		east += length * sin(radians)
+		north += length * cos(radians)
+		guard referenceLatitude != nil else { return }
+		predictVariance(to: time)
+		let alongTrack = length * strideUncertainty
+		let crossTrack = length * headingUncertainty * .pi / 180
+		variance += alongTrack * alongTrack + crossTrack * crossTrack
+	}
+
+	private func notifyDelegate() {
+		guard let refLatitude = referenceLatitude else { return } //Without a first fix there is nothing to anchor the steps to
+		let latitude = refLatitude + (north - pendingNorth) / PedestrianDeadReckoning.metersPerDegreeLatitude
+		let longitude = referenceLongitude + (east - pendingEast) / metersPerDegreeLongitude
+		delegate?.pedestrianDeadReckoning(self, didUpdateLatitude: latitude, longitude: longitude)
+	}
+}
@@ -0,0 +1,110 @@
+//
+//  HeadGestureRecognizerTests.swift
+//  Swift Headset XTests
+//
+//  Created by Florian Heller on 19.10.26.
+//  Copyright © 2026 Florian Heller. All rights reserved.
+//
+
+import XCTest
+@testable import Swift_Headset_X
+
+class HeadGestureRecognizerTests: XCTestCase, HeadGestureRecognizerDelegate {
+
+	let sampleRate = 50.0
+	var recognizer: HeadGestureRecognizer!
+	var gestures = [HeadGesture]()
+
+	override func setUp() {
+		super.setUp()
+		recognizer = HeadGestureRecognizer()
+		recognizer.delegate = self
+		gestures = []
+	}
+
+	func headGestureRecognizer(_ recognizer: HeadGestureRecognizer, didRecognize gesture: HeadGesture) {
+		gestures.append(gesture)
+	}
+
+	//MARK: Synthetic sensor streams
+
+	/// Feeds `duration` seconds of samples at the sensor rate, the closure returns yaw, pitch and roll in degrees for a point in time
+	func feed(duration: TimeInterval, _ orientation: (TimeInterval) -> (yaw: Float, pitch: Float, roll: Float)) {
+		for i in 0...Int(duration * sampleRate) {
+			let time = Double(i) / sampleRate
+			let sample = orientation(time)
+			recognizer.add(yaw: sample.yaw, pitch: sample.pitch, roll: sample.roll, at: time)
+		}
+	}
+
+	/// Sine movement that stops after the given number of cycles
+	func oscillation(at time: TimeInterval, amplitude: Float, frequency: Double, cycles: Double) -> Float {
+		guard time >= 0 && time < cycles / frequency else { return 0 }
+		return amplitude * Float(sin(2 * .pi * frequency * time))
+	}
+
+	func wrapped(_ yaw: Float) -> Float {
+		let angle = yaw.truncatingRemainder(dividingBy: 360)
+		return angle < 0 ? angle + 360 : angle
+	}
+
+	//MARK: Gestures
+
+	func testNodFiresOnce() {
+		feed(duration: 2) { t in (0, oscillation(at: t, amplitude: 15, frequency: 2, cycles: 1), 0) }
+		XCTAssertEqual(gestures, [.nod])
+	}
+
+	func testShakeFiresOnce() {
+		//Around north, so yaw wraps between 350 and 10 degrees
+		feed(duration: 2) { t in (wrapped(oscillation(at: t, amplitude: 20, frequency: 2.5, cycles: 3)), 0, 0) }
+		XCTAssertEqual(gestures, [.shake])
+	}
+
+	func testTiltRightFiresOnce() {
+		feed(duration: 2) { t in (0, 0, t >= 0.5 && t < 1.5 ? 30 : 0) }
+		XCTAssertEqual(gestures, [.tiltRight])
+	}
+
+	func testTiltLeftFiresOnce() {
+		feed(duration: 2) { t in (0, 0, t >= 0.5 && t < 1.5 ? -30 : 0) }
+		XCTAssertEqual(gestures, [.tiltLeft])
+	}
+
+	//MARK: Movements that are not gestures
+
+	func testSlowHeadTurnFiresNothing() {
+		feed(duration: 5) { t in (wrapped(Float(30 * t)), 0, 0) }
+		XCTAssertEqual(gestures, [])
+	}
+
+	func testSlowDriftFiresNothing() {
+		feed(duration: 8) { t in (0, Float(min(t, 5)), Float(min(t, 5) * 1.5)) }
+		XCTAssertEqual(gestures, [])
+	}
+
+	func testBriefRollSpikeFiresNothing() {
+		//Past the tilt angle only for a moment, then held below it
+		feed(duration: 2) { t in (0, 0, t >= 0.5 && t < 0.55 ? 25 : (t >= 0.5 && t < 1.5 ? 12 : 0)) }
+		XCTAssertEqual(gestures, [])
+	}
+
+	//MARK: Refractory period
+
+	func testLongNodIsReportedOnce() {
+		feed(duration: 3) { t in (0, oscillation(at: t, amplitude: 15, frequency: 2, cycles: 3), 0) }
+		XCTAssertEqual(gestures, [.nod])
+	}
+
+	func testLongShakeIsReportedOnce() {
+		feed(duration: 3) { t in (oscillation(at: t, amplitude: 20, frequency: 2.5, cycles: 5) + 180, 0, 0) }
+		XCTAssertEqual(gestures, [.shake])
+	}
+
+	func testSeparateNodsAreReportedTwice() {
+		feed(duration: 4) { t in
+			(0, oscillation(at: t, amplitude: 15, frequency: 2, cycles: 1) + oscillation(at: t - 2, amplitude: 15, frequency: 2, cycles: 1), 0)
+		}
+		XCTAssertEqual(gestures, [.nod, .nod])
+	}
+}
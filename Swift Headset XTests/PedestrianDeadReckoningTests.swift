@@ -0,0 +1,76 @@
+//
+//  PedestrianDeadReckoningTests.swift
+//  Swift Headset XTests
+//
+//  Created by Florian Heller on 19.10.26.
+//  Copyright © 2026 Florian Heller. All rights reserved.
+//
+
+import XCTest
+@testable import Swift_Headset_X
+
+class PedestrianDeadReckoningTests: XCTestCase, PedestrianDeadReckoningDelegate {
+
+	let latitude = 50.0
+	let longitude = 6.0
+	var pdr: PedestrianDeadReckoning!
+	var positions = [(latitude: Double, longitude: Double)]()
+
+	override func setUp() {
+		super.setUp()
+		pdr = PedestrianDeadReckoning()
+		pdr.delegate = self
+		pdr.updateHorizontalAccuracy(30)
+		positions = []
+	}
+
+	func pedestrianDeadReckoning(_ pdr: PedestrianDeadReckoning, didUpdateLatitude latitude: Double, longitude: Double) {
+		positions.append((latitude, longitude))
+	}
+
+	/// Meters north of the test location of the last published position
+	var lastNorth: Double {
+		return ((positions.last?.latitude ?? latitude) - latitude) * PedestrianDeadReckoning.metersPerDegreeLatitude
+	}
+
+	/// Standing still with 1 Hz fixes at the test location, accelerometer samples at 50 Hz
+	func standStill(from start: TimeInterval, seconds: Int) {
+		for second in 0..<seconds {
+			let time = start + Double(second)
+			pdr.addLocation(latitude: latitude, longitude: longitude, at: time)
+			for sample in 1..<50 {
+				pdr.addAcceleration(x: 0, y: 0, z: 1, at: time + Double(sample) / 50)
+			}
+		}
+	}
+
+	func testFilterKeepsListeningToGPS() {
+		standStill(from: 0, seconds: 60)
+		//A fix 30 m north after a minute of consistent fixes still has to move the estimate
+		pdr.addLocation(latitude: latitude + 30 / PedestrianDeadReckoning.metersPerDegreeLatitude, longitude: longitude, at: 60)
+		for sample in 1...500 {
+			pdr.addAcceleration(x: 0, y: 0, z: 1, at: 60 + Double(sample) / 50)
+		}
+		XCTAssertGreaterThan(lastNorth, 1.0)
+	}
+
+	func testCorrectionIsSpreadOverSamples() {
+		standStill(from: 0, seconds: 10)
+		pdr.addLocation(latitude: latitude + 30 / PedestrianDeadReckoning.metersPerDegreeLatitude, longitude: longitude, at: 10)
+		XCTAssertEqual(lastNorth, 0, accuracy: 0.001, "The published position must not jump on a fix")
+		pdr.addAcceleration(x: 0, y: 0, z: 1, at: 10.02)
+		let afterFirstSample = lastNorth
+		for sample in 2...500 {
+			pdr.addAcceleration(x: 0, y: 0, z: 1, at: 10 + Double(sample) / 50)
+		}
+		XCTAssertGreaterThan(afterFirstSample, 0)
+		XCTAssertLessThan(afterFirstSample, lastNorth / 10)
+	}
+
+	func testInvalidFixIsIgnored() {
+		pdr.addLocation(latitude: latitude, longitude: longitude, at: 0)
+		pdr.updateHorizontalAccuracy(-1)
+		pdr.addLocation(latitude: latitude + 0.01, longitude: longitude, at: 1)
+		XCTAssertEqual(positions.count, 1)
+	}
+}